@@ -11,6 +11,10 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <ElegantOTA.h>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include "sensor_filter.h"
 
 // Constants
 #define DHTPIN 21
@@ -18,6 +22,14 @@
 #define DHT_TIMEOUT 2000
 #define MAX_DATA_POINTS 504
 
+// Sensor pipeline: a burst of reads spaced by the DHT22 minimum interval,
+// Hampel outlier rejection, median, then exponential smoothing (filter
+// tuning lives in sensor_filter.h)
+#define SENSOR_READ_INTERVAL_MS 2000
+#define SENSOR_UPDATE_INTERVAL_MS 60000
+#define SENSOR_MAX_RETRIES 3
+#define SENSOR_RETRY_BASE_MS 2000
+
 // Reduced JSON capacity to save memory
 const size_t JSON_CAPACITY = 50000;
 const unsigned long MAX_REASONABLE_TIMESTAMP = 1800000000UL;
@@ -48,8 +60,9 @@ float alertThreshold = 95.0;
 float humidityThreshold = 40.0;
 
 // Variables for sensor readings and timer
-float temperature = 0.0;
-float humidity = 0.0;
+// NAN until the first sensor burst completes
+float temperature = NAN;
+float humidity = NAN;
 unsigned long incubationStartTime = 0;
 
 // Data storage for graphs
@@ -62,39 +75,35 @@ DataPoint dataHistory[MAX_DATA_POINTS];
 int dataCount = 0;
 unsigned long lastDataLogTime = 0;
 
+// /data.json access: > 0 is the number of exports streaming from the file
+// (async_tcp task), -1 means a rewrite is in progress (loop or a handler).
+// A rewrite that finds readers is deferred via dataSavePending instead of
+// truncating a file an export is still reading.
+std::atomic<int> dataFileLock(0);
+std::atomic<bool> dataSavePending(false);
+File uploadFile;
+AsyncWebServerRequest *uploadOwner = nullptr;
+bool uploadRejected = false;
+
 // Function declarations
 String getTemperature();
 String getHumidity();
 String getIncubationTime();
 void resetIncubationTimer();
 String getDataJSON();
-void logDataPoint();
+bool logDataPoint();
 void loadDataFromFile();
 void saveDataToFile();
 void addDataPoint(unsigned long timestamp, float temp, float humid);
 void sendWebSocketUpdate();
+bool updateSensorPipeline();
+bool sensorReadingsReady();
 
 // WebSocket Event Handler
 void onWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
                       AwsEventType type, void *arg, uint8_t *data, size_t len) {
   if (type == WS_EVT_CONNECT) {
     Serial.println("WebSocket client connected");
-    float newTemp = dht.readTemperature(true);
-    float newHumid = dht.readHumidity();
-    if (!isnan(newTemp) && newTemp != 0.0) {
-      temperature = newTemp;
-      Serial.print("Immediate Temperature: ");
-      Serial.println(temperature);
-    } else {
-      Serial.println("Failed immediate temperature read");
-    }
-    if (!isnan(newHumid) && newHumid != 0.0) {
-      humidity = newHumid;
-      Serial.print("Immediate Humidity: ");
-      Serial.println(humidity);
-    } else {
-      Serial.println("Failed immediate humidity read");
-    }
     sendWebSocketUpdate();
   } else if (type == WS_EVT_DISCONNECT) {
     Serial.println("WebSocket client disconnected");
@@ -102,6 +111,27 @@ void onWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
 }
 
 // SPIFFS Data Functions
+bool tryLockDataFileRead() {
+  int n = dataFileLock.load();
+  while (n >= 0) {
+    if (dataFileLock.compare_exchange_weak(n, n + 1)) return true;
+  }
+  return false;
+}
+
+void unlockDataFileRead() {
+  dataFileLock.fetch_sub(1);
+}
+
+bool tryLockDataFileWrite() {
+  int expected = 0;
+  return dataFileLock.compare_exchange_strong(expected, -1);
+}
+
+void unlockDataFileWrite() {
+  dataFileLock.store(0);
+}
+
 void loadDataFromFile() {
   if (!SPIFFS.exists("/data.json")) {
     dataCount = 0;
@@ -156,16 +186,255 @@ void saveDataToFile() {
     point["temperature"] = roundedTemp;
     point["humidity"] = roundedHumid;
   }
+  if (!tryLockDataFileWrite()) {
+    dataSavePending = true;
+    Serial.println("Data file busy (export in progress); deferring save");
+    return;
+  }
+  dataSavePending = false;
   File file = SPIFFS.open("/data.json", FILE_WRITE);
   if (!file) {
+    unlockDataFileWrite();
     Serial.println("Failed to open data file for writing");
     return;
   }
   serializeJson(doc, file);
   file.close();
+  unlockDataFileWrite();
   Serial.printf("Saved %d data points to SPIFFS\n", dataCount);
 }
 
+// Clearing history goes through the same lock; if an export holds the file
+// the deferred save later overwrites it with the (now empty) history.
+void removeDataFile() {
+  if (!tryLockDataFileWrite()) {
+    dataSavePending = true;
+    Serial.println("Data file busy (export in progress); deferring clear");
+    return;
+  }
+  SPIFFS.remove("/data.json");
+  unlockDataFileWrite();
+}
+
+// Streaming Export
+// Records are pulled straight out of /data.json one object at a time, so the
+// export never holds more than one record plus a small read buffer in RAM.
+enum ExportFormat { EXPORT_CSV, EXPORT_NDJSON, EXPORT_BIN };
+
+struct ExportState {
+  File file;
+  bool locked = false;
+  ExportFormat format;
+  unsigned long from;
+  unsigned long to;
+  bool headerSent = false;
+  bool done = false;
+  uint8_t in[512];
+  size_t inLen = 0;
+  size_t inPos = 0;
+  char rec[128];
+  size_t recLen = 0;
+  bool inRecord = false;
+  bool recOverflow = false;
+  uint8_t out[96];
+  size_t outLen = 0;
+  size_t outPos = 0;
+
+  // Runs when the response is freed, including on client disconnect
+  ~ExportState() {
+    if (file) file.close();
+    if (locked) unlockDataFileRead();
+  }
+};
+
+static bool parseExportBound(AsyncWebServerRequest *request, const char *name,
+                             unsigned long fallback, unsigned long &value) {
+  if (!request->hasParam(name)) {
+    value = fallback;
+    return true;
+  }
+  const String &param = request->getParam(name)->value();
+  if (param.length() == 0 || !isdigit((unsigned char)param[0])) return false;
+  char *end;
+  errno = 0;
+  value = strtoul(param.c_str(), &end, 10);
+  return *end == '\0' && errno != ERANGE;
+}
+
+static bool parseExportField(const char *rec, const char *key, double &value) {
+  const char *p = strstr(rec, key);
+  if (!p) return false;
+  p = strchr(p + strlen(key), ':');
+  if (!p) return false;
+  char *end;
+  value = strtod(p + 1, &end);
+  return end != p + 1;
+}
+
+// Scans forward to the next complete {...} object; returns false at end of file.
+static bool nextExportRecord(ExportState &st, DataPoint &point) {
+  while (true) {
+    if (st.inPos >= st.inLen) {
+      st.inLen = st.file ? st.file.read(st.in, sizeof(st.in)) : 0;
+      st.inPos = 0;
+      if (st.inLen == 0) return false;
+    }
+    char c = (char)st.in[st.inPos++];
+    if (!st.inRecord) {
+      if (c == '{') {
+        st.inRecord = true;
+        st.recLen = 0;
+        st.recOverflow = false;
+      }
+      continue;
+    }
+    if (c != '}') {
+      if (st.recLen < sizeof(st.rec) - 1) st.rec[st.recLen++] = c;
+      else st.recOverflow = true;
+      continue;
+    }
+    st.inRecord = false;
+    st.rec[st.recLen] = '\0';
+    double ts, t, h;
+    if (st.recOverflow ||
+        !parseExportField(st.rec, "\"timestamp\"", ts) ||
+        !parseExportField(st.rec, "\"temperature\"", t) ||
+        !parseExportField(st.rec, "\"humidity\"", h)) {
+      continue;
+    }
+    point.timestamp = (unsigned long)ts;
+    point.temperature = (float)t;
+    point.humidity = (float)h;
+    return true;
+  }
+}
+
+static void formatExportRecord(ExportState &st, const DataPoint &point) {
+  st.outPos = 0;
+  switch (st.format) {
+    case EXPORT_CSV:
+      st.outLen = snprintf((char *)st.out, sizeof(st.out), "%lu,%.1f,%.1f\n",
+                           point.timestamp, point.temperature, point.humidity);
+      break;
+    case EXPORT_NDJSON:
+      st.outLen = snprintf((char *)st.out, sizeof(st.out),
+                           "{\"timestamp\":%lu,\"temperature\":%.1f,\"humidity\":%.1f}\n",
+                           point.timestamp, point.temperature, point.humidity);
+      break;
+    case EXPORT_BIN: {
+      // Packed little-endian record: uint32 timestamp, float32 temperature, float32 humidity
+      uint32_t ts = point.timestamp;
+      memcpy(st.out, &ts, 4);
+      memcpy(st.out + 4, &point.temperature, 4);
+      memcpy(st.out + 8, &point.humidity, 4);
+      st.outLen = 12;
+      break;
+    }
+  }
+  if (st.outLen >= sizeof(st.out)) st.outLen = sizeof(st.out) - 1;
+}
+
+size_t fillExportChunk(ExportState &st, uint8_t *buffer, size_t maxLen) {
+  size_t written = 0;
+  while (written < maxLen) {
+    if (st.outPos < st.outLen) {
+      size_t n = min(st.outLen - st.outPos, maxLen - written);
+      memcpy(buffer + written, st.out + st.outPos, n);
+      st.outPos += n;
+      written += n;
+      continue;
+    }
+    if (st.done) break;
+    if (!st.headerSent) {
+      st.headerSent = true;
+      if (st.format == EXPORT_CSV) {
+        st.outLen = snprintf((char *)st.out, sizeof(st.out), "timestamp,temperature,humidity\n");
+        st.outPos = 0;
+      }
+      continue;
+    }
+    DataPoint point;
+    if (!nextExportRecord(st, point)) {
+      st.done = true;
+      break;
+    }
+    if (point.timestamp > st.to) {
+      // History is appended in timestamp order, so nothing later can match
+      st.done = true;
+      break;
+    }
+    if (point.timestamp < st.from) continue;
+    formatExportRecord(st, point);
+  }
+  return written;
+}
+
+void handleExport(AsyncWebServerRequest *request) {
+  String format = request->hasParam("format") ? request->getParam("format")->value() : "csv";
+  std::shared_ptr<ExportState> st(new (std::nothrow) ExportState());
+  if (!st) {
+    request->send(503, "text/plain", "Out of memory");
+    return;
+  }
+
+  const char *contentType;
+  const char *disposition;
+  if (format == "csv") {
+    st->format = EXPORT_CSV;
+    contentType = "text/csv";
+    disposition = "attachment; filename=\"data.csv\"";
+  } else if (format == "ndjson") {
+    st->format = EXPORT_NDJSON;
+    contentType = "application/x-ndjson";
+    disposition = "attachment; filename=\"data.ndjson\"";
+  } else if (format == "bin") {
+    st->format = EXPORT_BIN;
+    contentType = "application/octet-stream";
+    disposition = "attachment; filename=\"data.bin\"";
+  } else {
+    request->send(400, "text/plain", "Unknown format (use csv, ndjson or bin)");
+    return;
+  }
+
+  if (!parseExportBound(request, "from", 0, st->from) ||
+      !parseExportBound(request, "to", ULONG_MAX, st->to)) {
+    request->send(400, "text/plain", "Invalid range: from/to must be epoch seconds");
+    return;
+  }
+  if (st->from > st->to) {
+    request->send(400, "text/plain", "Invalid range: from > to");
+    return;
+  }
+
+  // Held until the response is freed so the file is not rewritten mid-stream
+  if (!tryLockDataFileRead()) {
+    request->send(503, "text/plain", "History is being saved; try again");
+    return;
+  }
+  st->locked = true;
+  if (SPIFFS.exists("/data.json")) {
+    st->file = SPIFFS.open("/data.json", FILE_READ);
+  }
+
+  AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+    [st](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return fillExportChunk(*st, buffer, maxLen);
+    });
+  response->addHeader("Content-Disposition", disposition);
+  request->send(response);
+}
+
+// An upload holds the data file write lock from its first chunk until the
+// last one, or until the client disconnects mid-upload
+void releaseUpload(AsyncWebServerRequest *request, bool completed) {
+  if (uploadOwner != request) return;
+  if (uploadFile) uploadFile.close();
+  uploadOwner = nullptr;
+  // The uploaded file replaces the history; drop any save deferred before it
+  if (completed) dataSavePending = false;
+  unlockDataFileWrite();
+}
+
 // Helper Functions
 String getTemperature() {
   if (isnan(temperature)) return "Error";
@@ -231,7 +500,7 @@ void resetIncubationTimer() {
   incubationStartTime = timeClient.getEpochTime();
   lastDataLogTime = 0;
   dataCount = 0;
-  SPIFFS.remove("/data.json");
+  removeDataFile();
 
   preferences.begin("egg-timer", false);
   preferences.putULong("startTime", incubationStartTime);
@@ -239,11 +508,11 @@ void resetIncubationTimer() {
   Serial.println("Incubation timer reset and SPIFFS data cleared");
 }
 
-void logDataPoint() {
+bool logDataPoint() {
   unsigned long sensorTime = timeClient.getEpochTime();
   if (sensorTime > MAX_REASONABLE_TIMESTAMP) {
     Serial.println("Detected erroneous future timestamp; skipping data point");
-    return;
+    return false;
   }
 
   if (!isnan(temperature) && !isnan(humidity) && temperature != 0.0 && humidity != 0.0) {
@@ -252,9 +521,139 @@ void logDataPoint() {
     addDataPoint(sensorTime, roundedTemp, roundedHumid);
     saveDataToFile();
     Serial.println("Data point logged");
+    return true;
+  }
+  Serial.println("Invalid sensor readings; skipping data point");
+  return false;
+}
+
+// Sensor Pipeline
+struct SensorStats {
+  unsigned long reads;
+  unsigned long readFailures;
+  unsigned long tempOutliers;
+  unsigned long humidOutliers;
+  unsigned long burstsOk;
+  unsigned long burstsFailed;
+  unsigned long retries;
+  unsigned long retriesExhausted;
+};
+SensorStats sensorStats = {};
+
+float tempSamples[SENSOR_BURST_SIZE];
+float humidSamples[SENSOR_BURST_SIZE];
+int tempSampleCount = 0;
+int humidSampleCount = 0;
+int burstReads = 0;
+bool burstActive = false;
+int sensorRetry = 0;
+// Channels already pushed into their EMA this update interval; a retry
+// after a partial failure only re-filters the channel that failed
+bool tempUpdated = false;
+bool humidUpdated = false;
+unsigned long burstStartMs = 0;
+unsigned long nextSensorActionMs = 0;
+EmaFilter tempEma(SENSOR_EMA_ALPHA);
+EmaFilter humidEma(SENSOR_EMA_ALPHA);
+
+bool sensorReadingsReady() {
+  return tempEma.primed && humidEma.primed;
+}
+
+// Non-blocking: takes at most one sensor read per call. Returns true when a
+// burst has finished and changed temperature and/or humidity.
+bool updateSensorPipeline() {
+  unsigned long nowMs = millis();
+  if ((long)(nowMs - nextSensorActionMs) < 0) return false;
+
+  if (!burstActive) {
+    burstActive = true;
+    burstReads = 0;
+    tempSampleCount = 0;
+    humidSampleCount = 0;
+    burstStartMs = nowMs;
+  }
+
+  // Force a fresh conversion; the humidity read reuses the same one
+  float newTemp = dht.readTemperature(true, true);
+  float newHumid = dht.readHumidity();
+  sensorStats.reads++;
+  bool tempValid = isValidTemperatureF(newTemp);
+  bool humidValid = isValidHumidity(newHumid);
+  if (tempValid) tempSamples[tempSampleCount++] = newTemp;
+  if (humidValid) humidSamples[humidSampleCount++] = newHumid;
+  if (!tempValid || !humidValid) sensorStats.readFailures++;
+
+  if (++burstReads < SENSOR_BURST_SIZE) {
+    nextSensorActionMs = nowMs + SENSOR_READ_INTERVAL_MS;
+    return false;
+  }
+  burstActive = false;
+
+  bool changed = false;
+  if (!tempUpdated) {
+    tempUpdated = filterBurst(tempSamples, tempSampleCount, tempEma,
+                              temperature, sensorStats.tempOutliers);
+    changed |= tempUpdated;
+  }
+  if (!humidUpdated) {
+    humidUpdated = filterBurst(humidSamples, humidSampleCount, humidEma,
+                               humidity, sensorStats.humidOutliers);
+    changed |= humidUpdated;
+  }
+
+  if (tempUpdated && humidUpdated) {
+    sensorStats.burstsOk++;
+    sensorRetry = 0;
+    tempUpdated = false;
+    humidUpdated = false;
+    nextSensorActionMs = burstStartMs + SENSOR_UPDATE_INTERVAL_MS;
+    Serial.printf("Temperature: %.1f °F, Humidity: %.1f %%\n", temperature, humidity);
   } else {
-    Serial.println("Invalid sensor readings; skipping data point");
+    sensorStats.burstsFailed++;
+    if (sensorRetry < SENSOR_MAX_RETRIES) {
+      unsigned long backoff = SENSOR_RETRY_BASE_MS << sensorRetry;
+      sensorRetry++;
+      sensorStats.retries++;
+      nextSensorActionMs = nowMs + backoff;
+      Serial.printf("Sensor burst failed (temp %d/%d, humid %d/%d valid); retry %d in %lu ms\n",
+                    tempSampleCount, SENSOR_BURST_SIZE, humidSampleCount, SENSOR_BURST_SIZE,
+                    sensorRetry, backoff);
+    } else {
+      // Mark a dead channel stale rather than holding its last value, so the
+      // UI shows "Error" and logDataPoint() skips it
+      if (!tempUpdated) {
+        temperature = NAN;
+        tempEma.reset();
+      }
+      if (!humidUpdated) {
+        humidity = NAN;
+        humidEma.reset();
+      }
+      changed = true;
+      sensorRetry = 0;
+      tempUpdated = false;
+      humidUpdated = false;
+      sensorStats.retriesExhausted++;
+      nextSensorActionMs = nowMs + SENSOR_UPDATE_INTERVAL_MS;
+      Serial.println("Sensor retries exhausted; readings marked stale until next update interval");
+    }
   }
+  return changed;
+}
+
+String getSensorStatsJSON() {
+  String json = "{";
+  json += "\"acquire\":{\"reads\":" + String(sensorStats.reads) +
+          ",\"failures\":" + String(sensorStats.readFailures) + "},";
+  json += "\"filter\":{\"tempOutliers\":" + String(sensorStats.tempOutliers) +
+          ",\"humidOutliers\":" + String(sensorStats.humidOutliers) + "},";
+  json += "\"burst\":{\"ok\":" + String(sensorStats.burstsOk) +
+          ",\"failed\":" + String(sensorStats.burstsFailed) + "},";
+  json += "\"retry\":{\"scheduled\":" + String(sensorStats.retries) +
+          ",\"exhausted\":" + String(sensorStats.retriesExhausted) + "}";
+  json += "}";
+  return json;
 }
 
 // Simplified WebSocket update - removed chunking to save memory
@@ -295,8 +694,8 @@ void sendWebSocketUpdate() {
   
   String json = "{";
   json += "\"type\":\"update\",";
-  json += "\"temperature\":" + String(temperature, 1) + ",";
-  json += "\"humidity\":" + String(humidity, 1) + ",";
+  json += "\"temperature\":" + (isnan(temperature) ? String("null") : String(temperature, 1)) + ",";
+  json += "\"humidity\":" + (isnan(humidity) ? String("null") : String(humidity, 1)) + ",";
   json += "\"incubationTime\":\"" + getIncubationTime() + "\",";
   json += "\"startTime\":" + String(incubationStartTime) + ",";
   if (count > 0) {
@@ -352,22 +751,18 @@ void handleSetStartTime(AsyncWebServerRequest *request) {
   Serial.printf("Updated startTime to %lu (offset %lu seconds)\n", incubationStartTime, offset);
 
   dataCount = 0;
-  SPIFFS.remove("/data.json");
+  removeDataFile();
 
-  float newTemp = dht.readTemperature(true);
-  float newHumid = dht.readHumidity();
   unsigned long now = timeClient.getEpochTime();
 
-  if (!isnan(newTemp) && newTemp != 0.0 && !isnan(newHumid) && newHumid != 0.0) {
-    temperature = newTemp;
-    humidity = newHumid;
+  if (sensorReadingsReady()) {
     skipNextLoopLog = true;
     lastDataLogTime = now;
     logDataPoint();
     Serial.println("Initial data point logged after /setstarttime");
     sendWebSocketUpdate();
   } else {
-    Serial.println("Skipping initial data log after /setstarttime due to invalid sensor reading");
+    Serial.println("Skipping initial data log after /setstarttime; no filtered sensor reading yet");
   }
 
   request->send(200, "text/plain", "Egg start time updated and history cleared.");
@@ -489,29 +884,43 @@ void setup() {
     request->send(SPIFFS, "/data.json", "application/json", true);
   });
 
+  // Stream history as CSV / NDJSON / packed binary, optionally limited to [from, to]
+  server.on("/export", HTTP_GET, handleExport);
+
   // Upload JSON HTML page - now served from SPIFFS
   server.on("/upload_json", HTTP_GET, [](AsyncWebServerRequest *request){
     request->send(SPIFFS, "/upload.html", "text/html");
   });  
 
   server.on("/upload_json", HTTP_POST, [](AsyncWebServerRequest *request) {
+    bool rejected = uploadRejected;
+    uploadRejected = false;
+    if (rejected) {
+      request->send(409, "text/plain", "Data file busy (export or save in progress); upload discarded. Try again.");
+      return;
+    }
     request->send(200, "text/plain", "Upload complete. Reboot device or refresh chart.");
   }, [](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
-    static File uploadFile;
-
     if (index == 0) {
+      if (uploadOwner || !tryLockDataFileWrite()) {
+        uploadRejected = true;
+        return;
+      }
+      uploadOwner = request;
+      request->onDisconnect([request]() { releaseUpload(request, false); });
       if (SPIFFS.exists("/data.json")) {
         SPIFFS.remove("/data.json");
       }
       uploadFile = SPIFFS.open("/data.json", FILE_WRITE);
     }
+    if (request != uploadOwner) return;
 
     if (uploadFile) {
       uploadFile.write(data, len);
     }
 
     if (final) {
-      uploadFile.close();
+      releaseUpload(request, true);
     }
   });
 
@@ -549,20 +958,16 @@ void setup() {
     Serial.println("Timer reset requested");
     resetIncubationTimer();
 
-    float newTemp = dht.readTemperature(true);
-    float newHumid = dht.readHumidity();
     unsigned long now = timeClient.getEpochTime();
 
-    if (!isnan(newTemp) && newTemp != 0.0 && !isnan(newHumid) && newHumid != 0.0) {
-      temperature = newTemp;
-      humidity = newHumid;
+    if (sensorReadingsReady()) {
       skipNextLoopLog = true;
       lastDataLogTime = now;
       logDataPoint();
       Serial.println("Initial data point logged after reset");
       sendWebSocketUpdate();
     } else {
-      Serial.println("Skipping initial data log after reset due to invalid sensor reading");
+      Serial.println("Skipping initial data log after reset; no filtered sensor reading yet");
     }
 
     request->send(200, "text/plain", "Timer and all data reset");
@@ -573,6 +978,10 @@ void setup() {
     request->send(200, "application/json", getDataJSON());
   });
 
+  server.on("/sensorstats", HTTP_GET, [](AsyncWebServerRequest *request) {
+    request->send(200, "application/json", getSensorStatsJSON());
+  });
+
   // Threshold endpoints
   server.on("/getthreshold", HTTP_GET, [](AsyncWebServerRequest *request){
     preferences.begin("threshold-store", true);
@@ -633,47 +1042,37 @@ void loop() {
     timeClient.update();
     unsigned long currentEpoch = timeClient.getEpochTime();
 
-    // Log data point every hour (3600 seconds)
+    // Log data point every hour (3600 seconds). If the readings are stale
+    // the hour stays due and is retried once per sensor update interval.
+    static unsigned long lastLogAttempt = 0;
     if (currentEpoch > 1600000000 &&
-        (lastDataLogTime == 0 || currentEpoch - lastDataLogTime >= 3600)) {
+        (lastDataLogTime == 0 || currentEpoch - lastDataLogTime >= 3600) &&
+        currentEpoch - lastLogAttempt >= SENSOR_UPDATE_INTERVAL_MS / 1000) {
 
       if (skipNextLoopLog) {
         Serial.println("Skipping one loop-triggered data log (already logged manually)");
         skipNextLoopLog = false;
       } else {
-        logDataPoint();
-        lastDataLogTime = currentEpoch;
-        Serial.println("Data point logged from loop");
+        lastLogAttempt = currentEpoch;
+        if (logDataPoint()) {
+          lastDataLogTime = currentEpoch;
+          Serial.println("Data point logged from loop");
+        }
       }
     }
   
 
-    // Update sensor readings every minute
-    static unsigned long lastSensorUpdate = 0;
-    if (millis() - lastSensorUpdate > 60000) {
-      float newTemp = dht.readTemperature(true);
-      float newHumid = dht.readHumidity();
-      if (!isnan(newTemp) && newTemp != 0.0) {
-        temperature = newTemp;
-        Serial.print("Temperature: ");
-        Serial.print(temperature);
-        Serial.println(" °F");
-      } else {
-        Serial.println("Failed to read temperature!");
-      }
-      if (!isnan(newHumid) && newHumid != 0.0) {
-        humidity = newHumid;
-        Serial.print("Humidity: ");
-        Serial.print(humidity);
-        Serial.println(" %");
-      } else {
-        Serial.println("Failed to read humidity!");
-      }
-      lastSensorUpdate = millis();
+    // Sample the sensor in bursts every minute; one read per loop pass
+    if (updateSensorPipeline()) {
       sendWebSocketUpdate();
     }
   }
   
+  // Flush a save that was deferred while an export held the data file
+  if (dataSavePending && dataFileLock.load() == 0) {
+    saveDataToFile();
+  }
+
   static unsigned long lastWifiCheck = 0;
   if (millis() - lastWifiCheck > 10000) {
     if (WiFi.status() != WL_CONNECTED) {
@@ -0,0 +1,79 @@
+#include "sensor_filter.h"
+
+#include <math.h>
+
+bool isValidTemperatureF(float value) {
+  // DHT22 range is -40..80 °C
+  return !isnan(value) && value != 0.0f && value > -40.0f && value < 176.0f;
+}
+
+bool isValidHumidity(float value) {
+  return !isnan(value) && value > 0.0f && value <= 100.0f;
+}
+
+float medianOf(const float *values, size_t n) {
+  if (n > SENSOR_FILTER_MAX_SAMPLES) n = SENSOR_FILTER_MAX_SAMPLES;
+
+  // Insertion sort on a scratch copy; bursts are only a handful of samples
+  float sorted[SENSOR_FILTER_MAX_SAMPLES];
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++) {
+    float v = values[i];
+    if (isnan(v)) continue;
+    size_t j = count++;
+    while (j > 0 && sorted[j - 1] > v) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+  if (count == 0) return NAN;
+  if (count & 1) return sorted[count / 2];
+  return (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5f;
+}
+
+size_t hampelFilter(const float *in, size_t n, float k, float minDeviation, float *out) {
+  if (n > SENSOR_FILTER_MAX_SAMPLES) n = SENSOR_FILTER_MAX_SAMPLES;
+
+  float median = medianOf(in, n);
+  if (isnan(median)) return 0;
+
+  float deviations[SENSOR_FILTER_MAX_SAMPLES];
+  float closest = INFINITY;
+  for (size_t i = 0; i < n; i++) {
+    deviations[i] = fabsf(in[i] - median);
+    if (deviations[i] < closest) closest = deviations[i];
+  }
+
+  // 1.4826 scales the MAD to a standard deviation for Gaussian noise
+  float limit = k * 1.4826f * medianOf(deviations, n);
+  if (limit < minDeviation) limit = minDeviation;
+  // Never reject every sample: the one nearest the median always survives
+  if (limit < closest) limit = closest;
+
+  size_t kept = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (deviations[i] <= limit) out[kept++] = in[i];
+  }
+  return kept;
+}
+
+float EmaFilter::update(float x) {
+  if (!primed) {
+    value = x;
+    primed = true;
+  } else {
+    value += alpha * (x - value);
+  }
+  return value;
+}
+
+bool filterBurst(const float *samples, size_t count, EmaFilter &ema,
+                 float &result, unsigned long &outliers) {
+  if (count < SENSOR_MIN_VALID_SAMPLES) return false;
+  float inliers[SENSOR_FILTER_MAX_SAMPLES];
+  size_t kept = hampelFilter(samples, count, SENSOR_HAMPEL_K, SENSOR_MIN_DEVIATION, inliers);
+  outliers += count - kept;
+  result = ema.update(medianOf(inliers, kept));
+  return true;
+}
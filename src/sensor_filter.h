@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+
+#define SENSOR_FILTER_MAX_SAMPLES 16
+
+// Filter tuning shared by the firmware pipeline and the host tests
+#define SENSOR_BURST_SIZE 5
+#define SENSOR_MIN_VALID_SAMPLES 3
+#define SENSOR_HAMPEL_K 3.0f
+#define SENSOR_MIN_DEVIATION 0.3f
+#define SENSOR_EMA_ALPHA 0.3f
+
+static_assert(SENSOR_BURST_SIZE <= SENSOR_FILTER_MAX_SAMPLES,
+              "SENSOR_BURST_SIZE exceeds what the filter kernels accept");
+
+// Signal-processing kernels for the DHT22 read pipeline. Kept free of any
+// Arduino dependency so they can be compiled and checked on the host
+// against sensor traces.
+
+// Plausibility checks for a single raw read (temperature in °F). The DHT
+// library reports some failed reads as 0 rather than NaN, so 0 is rejected.
+bool isValidTemperatureF(float value);
+bool isValidHumidity(float value);
+
+// Median of n values (n <= SENSOR_FILTER_MAX_SAMPLES), ignoring NaNs.
+// Returns NAN when no valid value is left.
+float medianOf(const float *values, size_t n);
+
+// Hampel filter: copies to `out` every sample within k scaled MADs of the
+// median and returns how many were kept. NaNs are always dropped. Unless
+// every input is NaN at least one sample is kept. `minDeviation` is a floor
+// on the accepted deviation so a burst of identical readings (MAD == 0) does
+// not reject a neighbour that differs only by the sensor's 0.1 resolution.
+size_t hampelFilter(const float *in, size_t n, float k, float minDeviation, float *out);
+
+// Exponential moving average; the first sample primes the filter.
+struct EmaFilter {
+  float alpha;
+  float value;
+  bool primed;
+
+  explicit EmaFilter(float a) : alpha(a), value(0.0f), primed(false) {}
+  float update(float x);
+  void reset() { primed = false; }
+};
+
+// Reduces the valid samples of one channel's burst to a single smoothed
+// value: Hampel filter, median of the survivors, then `ema`. Returns false
+// (leaving `ema` and `result` untouched) when fewer than
+// SENSOR_MIN_VALID_SAMPLES are given. Rejected samples are added to
+// `outliers`.
+bool filterBurst(const float *samples, size_t count, EmaFilter &ema,
+                 float &result, unsigned long &outliers);
@@ -0,0 +1,157 @@
+#include <math.h>
+#include <unity.h>
+
+#include "sensor_filter.h"
+
+// Synthetic DHT22 trace (hand-built, not captured from hardware) in the
+// firmware's bursts of SENSOR_BURST_SIZE raw reads. Covers single-read
+// spikes, failed reads (NaN and the library's 0.0), an out-of-range read,
+// a burst of identical readings and a burst with too few valid reads.
+static const float TEMP_TRACE[][SENSOR_BURST_SIZE] = {
+  {99.5f, 99.6f, 99.5f, 99.6f, 99.5f},
+  {99.6f, 132.4f, 99.5f, 99.6f, 99.7f},
+  {NAN, 99.7f, 0.0f, 99.6f, 99.7f},
+  {99.8f, 99.8f, 99.8f, 99.8f, 99.9f},
+  {NAN, 99.2f, NAN, 0.0f, 99.1f},
+  {99.7f, 99.7f, 99.7f, 99.7f, 99.7f},
+  {99.6f, 99.7f, 31.8f, 99.6f, 99.7f},
+};
+static const float HUMID_TRACE[][SENSOR_BURST_SIZE] = {
+  {45.1f, 45.2f, 45.2f, 45.1f, 45.2f},
+  {45.2f, 45.3f, 12.0f, 45.2f, 45.3f},
+  {NAN, 45.3f, 0.0f, 45.2f, 45.3f},
+  {45.4f, 45.4f, 45.4f, 45.4f, 45.4f},
+  {NAN, 44.8f, NAN, 0.0f, 44.9f},
+  {45.3f, 45.4f, 45.3f, 99.9f, 45.3f},
+  {45.3f, 45.3f, 45.2f, 45.3f, 120.0f},
+};
+// Bursts with fewer than SENSOR_MIN_VALID_SAMPLES valid reads
+static const bool TRACE_SHORT_BURST[] = {false, false, false, false, true, false, false};
+static const size_t TRACE_BURSTS = sizeof(TEMP_TRACE) / sizeof(TEMP_TRACE[0]);
+
+void setUp() {}
+void tearDown() {}
+
+void test_median_odd_and_even() {
+  const float odd[] = {3.0f, 1.0f, 2.0f};
+  const float even[] = {4.0f, 1.0f, 3.0f, 2.0f};
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, medianOf(odd, 3));
+  TEST_ASSERT_EQUAL_FLOAT(2.5f, medianOf(even, 4));
+}
+
+void test_median_ignores_nan() {
+  const float values[] = {NAN, 5.0f, 1.0f, NAN, 3.0f};
+  const float allNan[] = {NAN, NAN};
+  TEST_ASSERT_EQUAL_FLOAT(3.0f, medianOf(values, 5));
+  TEST_ASSERT_TRUE(isnan(medianOf(allNan, 2)));
+  TEST_ASSERT_TRUE(isnan(medianOf(values, 0)));
+}
+
+void test_hampel_rejects_single_spike() {
+  const float in[] = {99.5f, 99.6f, 99.5f, 132.0f, 99.4f};
+  float out[5];
+  TEST_ASSERT_EQUAL(4, hampelFilter(in, 5, 3.0f, 0.3f, out));
+  for (size_t i = 0; i < 4; i++) TEST_ASSERT_FLOAT_WITHIN(0.2f, 99.5f, out[i]);
+}
+
+void test_hampel_zero_mad_keeps_resolution_step() {
+  const float step[] = {50.0f, 50.0f, 50.0f, 50.1f};
+  const float spike[] = {50.0f, 50.0f, 50.0f, 58.0f};
+  float out[4];
+  TEST_ASSERT_EQUAL(4, hampelFilter(step, 4, 3.0f, 0.3f, out));
+  TEST_ASSERT_EQUAL(3, hampelFilter(spike, 4, 3.0f, 0.3f, out));
+}
+
+void test_hampel_drops_nan() {
+  const float in[] = {NAN, 45.3f, NAN, 45.2f, 45.3f};
+  float out[5];
+  TEST_ASSERT_EQUAL(3, hampelFilter(in, 5, 3.0f, 0.3f, out));
+  for (size_t i = 0; i < 3; i++) TEST_ASSERT_FALSE(isnan(out[i]));
+}
+
+void test_hampel_never_rejects_every_sample() {
+  const float spread[] = {1.0f, 10.0f};
+  const float allNan[] = {NAN, NAN, NAN};
+  float out[3];
+  TEST_ASSERT_TRUE(hampelFilter(spread, 2, 0.0f, 0.0f, out) >= 1);
+  TEST_ASSERT_EQUAL(0, hampelFilter(allNan, 3, 3.0f, 0.3f, out));
+}
+
+void test_ema_primes_then_smooths() {
+  EmaFilter ema(0.5f);
+  TEST_ASSERT_FALSE(ema.primed);
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, ema.update(10.0f));
+  TEST_ASSERT_EQUAL_FLOAT(15.0f, ema.update(20.0f));
+  ema.reset();
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, ema.update(40.0f));
+}
+
+void test_valid_reading_checks() {
+  TEST_ASSERT_TRUE(isValidTemperatureF(99.5f));
+  TEST_ASSERT_FALSE(isValidTemperatureF(NAN));
+  TEST_ASSERT_FALSE(isValidTemperatureF(0.0f));
+  TEST_ASSERT_FALSE(isValidTemperatureF(200.0f));
+  TEST_ASSERT_TRUE(isValidHumidity(45.0f));
+  TEST_ASSERT_FALSE(isValidHumidity(NAN));
+  TEST_ASSERT_FALSE(isValidHumidity(0.0f));
+  TEST_ASSERT_FALSE(isValidHumidity(120.0f));
+}
+
+void test_filter_burst_needs_min_valid_samples() {
+  const float two[] = {99.5f, 99.6f};
+  EmaFilter ema(SENSOR_EMA_ALPHA);
+  float result = -1.0f;
+  unsigned long outliers = 0;
+  TEST_ASSERT_FALSE(filterBurst(two, 2, ema, result, outliers));
+  TEST_ASSERT_FALSE(ema.primed);
+  TEST_ASSERT_EQUAL_FLOAT(-1.0f, result);
+}
+
+// Same steps updateSensorPipeline() takes per burst: drop invalid raw reads,
+// then filterBurst() (min-valid gate, Hampel, median, EMA)
+static void replayTrace(const float (*trace)[SENSOR_BURST_SIZE], bool (*isValid)(float),
+                        float expected, float tolerance, unsigned long expectedOutliers) {
+  EmaFilter ema(SENSOR_EMA_ALPHA);
+  unsigned long outliers = 0;
+  for (size_t b = 0; b < TRACE_BURSTS; b++) {
+    float samples[SENSOR_BURST_SIZE];
+    size_t count = 0;
+    for (size_t i = 0; i < SENSOR_BURST_SIZE; i++) {
+      if (isValid(trace[b][i])) samples[count++] = trace[b][i];
+    }
+    float previous = ema.value;
+    float result = NAN;
+    bool updated = filterBurst(samples, count, ema, result, outliers);
+    TEST_ASSERT_EQUAL(!TRACE_SHORT_BURST[b], updated);
+    if (updated) {
+      TEST_ASSERT_FLOAT_WITHIN(tolerance, expected, result);
+    } else {
+      TEST_ASSERT_EQUAL_FLOAT(previous, ema.value);
+    }
+  }
+  TEST_ASSERT_EQUAL(expectedOutliers, outliers);
+}
+
+void test_trace_temperature() {
+  replayTrace(TEMP_TRACE, isValidTemperatureF, 99.65f, 0.2f, 2);
+}
+
+void test_trace_humidity() {
+  replayTrace(HUMID_TRACE, isValidHumidity, 45.25f, 0.2f, 2);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_median_odd_and_even);
+  RUN_TEST(test_median_ignores_nan);
+  RUN_TEST(test_hampel_rejects_single_spike);
+  RUN_TEST(test_hampel_zero_mad_keeps_resolution_step);
+  RUN_TEST(test_hampel_drops_nan);
+  RUN_TEST(test_hampel_never_rejects_every_sample);
+  RUN_TEST(test_ema_primes_then_smooths);
+  RUN_TEST(test_valid_reading_checks);
+  RUN_TEST(test_filter_burst_needs_min_valid_samples);
+  RUN_TEST(test_trace_temperature);
+  RUN_TEST(test_trace_humidity);
+  return UNITY_END();
+}